@@ -0,0 +1,138 @@
+/**
+ * arena.c — Bump-pointer arena implementation.
+ *
+ * The arena is a singly-linked list of chunks.  Allocation bumps an offset
+ * in the current chunk; when that chunk is full the arena moves on to the
+ * next one, appending a fresh chunk only when the list is exhausted.
+ * arena_reset() just rewinds to the head chunk: chunks further down the list
+ * are rewound lazily as allocation reaches them again.
+ */
+
+#include "arena.h"
+
+#include <glib.h>
+#include <stdint.h>
+
+/* Alignment of every pointer returned by arena_alloc(). */
+#define ARENA_ALIGN 16
+
+/* -------------------------------------------------------------------------
+ * Internal types
+ * ---------------------------------------------------------------------- */
+
+/**
+ * ArenaChunk:
+ *
+ * One block of arena memory.  @data holds @size usable bytes, of which the
+ * first @used are handed out.
+ */
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    gsize              size;
+    gsize              used;
+    char               data[];
+} ArenaChunk;
+
+struct PluckArena {
+    ArenaChunk *head;
+    ArenaChunk *current;
+    gsize       chunk_size;
+};
+
+/* -------------------------------------------------------------------------
+ * Internal helpers
+ * ---------------------------------------------------------------------- */
+
+/**
+ * chunk_new:
+ * @size: Usable size of the chunk in bytes.
+ *
+ * Returns a new, empty, unlinked chunk.
+ */
+static ArenaChunk *chunk_new(gsize size)
+{
+    ArenaChunk *chunk = g_malloc(sizeof(ArenaChunk) + size);
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+/**
+ * chunk_padding:
+ * @chunk: The chunk about to be allocated from.
+ *
+ * Returns the number of bytes needed to bring the chunk's next free byte up
+ * to ARENA_ALIGN.
+ */
+static gsize chunk_padding(const ArenaChunk *chunk)
+{
+    uintptr_t next = (uintptr_t)(chunk->data + chunk->used);
+    return (gsize)(-next & (ARENA_ALIGN - 1));
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+PluckArena *arena_new(gsize chunk_size)
+{
+    PluckArena *arena = g_new(PluckArena, 1);
+    arena->chunk_size = chunk_size;
+    arena->head       = chunk_new(chunk_size);
+    arena->current    = arena->head;
+    return arena;
+}
+
+void arena_free(PluckArena *arena)
+{
+    if (!arena)
+        return;
+
+    ArenaChunk *chunk = arena->head;
+    while (chunk) {
+        ArenaChunk *next = chunk->next;
+        g_free(chunk);
+        chunk = next;
+    }
+    g_free(arena);
+}
+
+void arena_reset(PluckArena *arena)
+{
+    arena->head->used = 0;
+    arena->current    = arena->head;
+}
+
+gpointer arena_alloc(PluckArena *arena, gsize size)
+{
+    ArenaChunk *chunk = arena->current;
+
+    for (;;) {
+        gsize pad = chunk_padding(chunk);
+        if (pad + size <= chunk->size - chunk->used) {
+            gpointer ptr = chunk->data + chunk->used + pad;
+            chunk->used   += pad + size;
+            arena->current = chunk;
+            return ptr;
+        }
+
+        if (!chunk->next)
+            break;
+
+        /* Chunks past the current one only hold data from before the last
+         * reset, so they can be rewound as we step onto them. */
+        chunk       = chunk->next;
+        chunk->used = 0;
+    }
+
+    /* Out of chunks: append one big enough for this request. */
+    ArenaChunk *fresh = chunk_new(MAX(arena->chunk_size, size + ARENA_ALIGN));
+    chunk->next = fresh;
+
+    gsize pad = chunk_padding(fresh);
+    gpointer ptr = fresh->data + pad;
+    fresh->used    = pad + size;
+    arena->current = fresh;
+    return ptr;
+}
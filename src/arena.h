@@ -0,0 +1,58 @@
+/**
+ * arena.h — Bump-pointer arena for per-query scratch memory.
+ *
+ * Everything a single search needs (the shell command, fzf's output, match
+ * maps, markup strings and result records) is carved out of one arena.
+ * When the next keystroke arrives the whole lot is discarded at once with
+ * arena_reset(), which is O(1) and keeps every chunk for reuse, so once the
+ * arena has grown to fit a typical query no further heap allocations occur.
+ */
+
+#ifndef PLUCK_ARENA_H
+#define PLUCK_ARENA_H
+
+#include <glib.h>
+
+/** Opaque arena handle. */
+typedef struct PluckArena PluckArena;
+
+/**
+ * arena_new:
+ * @chunk_size: Usable size in bytes of each chunk the arena allocates.
+ *              Requests larger than this get a dedicated, larger chunk.
+ *
+ * Returns a new arena with one chunk already allocated.  Free it with
+ * arena_free().
+ */
+PluckArena *arena_new(gsize chunk_size);
+
+/**
+ * arena_free:
+ * @arena: The arena to destroy, or NULL.
+ *
+ * Releases every chunk owned by @arena and the arena itself.  All pointers
+ * previously returned by arena_alloc() become invalid.
+ */
+void arena_free(PluckArena *arena);
+
+/**
+ * arena_reset:
+ * @arena: The arena to rewind.
+ *
+ * Marks all memory in @arena as free without returning any of it to the
+ * system.  All pointers previously returned by arena_alloc() become invalid.
+ */
+void arena_reset(PluckArena *arena);
+
+/**
+ * arena_alloc:
+ * @arena: The arena to allocate from.
+ * @size:  Number of bytes required.
+ *
+ * Returns a pointer to @size bytes of uninitialised memory, suitably aligned
+ * for any scalar type.  The memory lives until the next arena_reset() or
+ * arena_free() and must not be passed to g_free().
+ */
+gpointer arena_alloc(PluckArena *arena, gsize size);
+
+#endif /* PLUCK_ARENA_H */
@@ -9,14 +9,12 @@
 #ifndef PLUCK_CONFIG_H
 #define PLUCK_CONFIG_H
 
-/** Maximum length of the search-root path (including NUL terminator). */
-#define SEARCH_ROOT_MAX 1024
-
 /**
  * Root directory passed to `fd` when scanning for files.
  * Defaults to "." (current working directory).
- * May be overridden via the first command-line argument.
+ * May be overridden via the first command-line argument, in which case it
+ * points straight at argv[1] and has no length limit.
  */
-extern char search_root[SEARCH_ROOT_MAX];
+extern const char *search_root;
 
 #endif /* PLUCK_CONFIG_H */
@@ -7,6 +7,9 @@
  *   search-root  Optional path to the directory that `fd` will scan.
  *                Defaults to "." (current working directory).
  *
+ * Environment:
+ *   PLUCK_TRACE  When set, print per-phase startup timings to stderr.
+ *
  * Pluck-GTK is a Wayland overlay file-search launcher built with GTK 4 and
  * gtk4-layer-shell.  It presents a floating search bar that pipes queries
  * through `fd` and `fzf`, then opens the selected file's containing folder
@@ -14,25 +17,42 @@
  */
 
 #include "config.h"
+#include "trace.h"
 #include "ui.h"
 
 #include <gtk/gtk.h>
-#include <string.h>
 
-/* Define the global search-root buffer declared in config.h. */
-char search_root[SEARCH_ROOT_MAX] = ".";
+/* Define the global search root declared in config.h. */
+const char *search_root = ".";
+
+/**
+ * on_startup:
+ *
+ * Connected to the GApplication "startup" signal.  The signal is RUN_FIRST,
+ * so GtkApplication's class handler has already run gtk_init() and opened
+ * the display by the time this fires; the trace mark separates that from
+ * application registration and activation dispatch.
+ */
+static void on_startup(GApplication *app, gpointer user_data)
+{
+    (void)app;
+    (void)user_data;
+    trace_mark("gtk initialised");
+}
 
 int main(int argc, char **argv)
 {
+    trace_init();
+
     /* Override the default search root if the user supplied a path. */
-    if (argc > 1) {
-        strncpy(search_root, argv[1], SEARCH_ROOT_MAX - 1);
-        search_root[SEARCH_ROOT_MAX - 1] = '\0';
-    }
+    if (argc > 1)
+        search_root = argv[1];
 
     GtkApplication *app = gtk_application_new("io.github.steffenblake.PluckGTK",
                                               G_APPLICATION_DEFAULT_FLAGS);
-    g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
+    g_signal_connect(app, "startup",  G_CALLBACK(on_startup), NULL);
+    g_signal_connect(app, "activate", G_CALLBACK(activate),   NULL);
+    trace_mark("application created");
 
     int status = g_application_run(G_APPLICATION(app), 0, NULL);
     g_object_unref(app);
@@ -10,14 +10,22 @@
  *      appears anywhere in @query.
  *
  * The result is a Pango markup string ready to hand to gtk_label_set_markup().
+ * Adjacent highlighted characters share one <span>.  The markup is measured
+ * in a first pass and written in a second, so it can be allocated from the
+ * query arena at its exact size without any intermediate buffers.
  */
 
 #include "search.h"
 
 #include <string.h>
+#include <stdio.h>
 #include <ctype.h>
 #include <glib.h>
 
+/* Markup wrapped around each run of highlighted characters. */
+#define HIGHLIGHT_OPEN  "<span weight='bold' foreground='#FFD700'>"
+#define HIGHLIGHT_CLOSE "</span>"
+
 /* -------------------------------------------------------------------------
  * Internal helpers
  * ---------------------------------------------------------------------- */
@@ -73,39 +81,126 @@ static gboolean find_exact_matches(const char *text,
     return found_any;
 }
 
-/* -------------------------------------------------------------------------
- * Public API
- * ---------------------------------------------------------------------- */
+/**
+ * emit:
+ * @out: Destination, or NULL to only measure.
+ * @pos: Current write offset into @out.
+ * @str: Bytes to append.
+ * @len: Number of bytes in @str.
+ *
+ * Copies @str to @out + @pos when @out is non-NULL.  Returns @pos + @len.
+ */
+static gsize emit(char *out, gsize pos, const char *str, gsize len)
+{
+    if (out)
+        memcpy(out + pos, str, len);
+    return pos + len;
+}
 
-char *create_highlighted_markup(const char *text, const char *query)
+/**
+ * emit_escaped:
+ * @out: Destination, or NULL to only measure.
+ * @pos: Current write offset into @out.
+ * @ch:  The character to append.
+ *
+ * Appends @ch with the five XML special characters replaced by entities and
+ * C0 control characters (except tab, newline and carriage return) and DEL
+ * replaced by numeric character references.  All other bytes are copied
+ * through unchanged.  Returns the new write offset.
+ */
+static gsize emit_escaped(char *out, gsize pos, char ch)
 {
-    GString *markup   = g_string_new("");
-    int      text_len = (int)strlen(text);
+    unsigned char c = (unsigned char)ch;
+
+    switch (c) {
+    case '&':  return emit(out, pos, "&amp;",  5);
+    case '<':  return emit(out, pos, "&lt;",   4);
+    case '>':  return emit(out, pos, "&gt;",   4);
+    case '\'': return emit(out, pos, "&apos;", 6);
+    case '"':  return emit(out, pos, "&quot;", 6);
+    default:
+        break;
+    }
 
-    /* Allocate a per-character highlight map. */
-    gboolean *exact_matches = g_new0(gboolean, text_len);
-    gboolean  has_exact     = find_exact_matches(text, query,
-                                                 exact_matches, text_len);
+    /* Control characters other than tab, newline and carriage return
+     * become numeric character references. */
+    if ((c >= 0x1 && c <= 0x8) || c == 0xb || c == 0xc ||
+        (c >= 0xe && c <= 0x1f) || c == 0x7f) {
+        char ref[8];
+        int  len = snprintf(ref, sizeof(ref), "&#x%x;", c);
+        return emit(out, pos, ref, (gsize)len);
+    }
+
+    return emit(out, pos, &ch, 1);
+}
+
+/**
+ * write_markup:
+ * @out:       Destination buffer, or NULL to only measure.
+ * @text:      The string being annotated.
+ * @text_len:  Number of characters in @text.
+ * @matches:   Exact-match map from find_exact_matches().
+ * @has_exact: Whether @matches holds any exact run.
+ * @query:     The user's search string.
+ *
+ * Writes the markup for @text to @out (without a NUL terminator) and returns
+ * its length in bytes.  Called once with @out == NULL to size the buffer and
+ * once more to fill it.
+ */
+static gsize write_markup(char           *out,
+                          const char     *text,
+                          int             text_len,
+                          const gboolean *matches,
+                          gboolean        has_exact,
+                          const char     *query)
+{
+    gsize    pos     = 0;
+    gboolean in_span = FALSE;
 
     for (int i = 0; i < text_len; i++) {
-        char  ch      = text[i];
-        char *escaped = g_markup_escape_text(&ch, 1);
+        char ch = text[i];
 
         gboolean highlight = has_exact
-            ? exact_matches[i]
+            ? matches[i]
             : char_in_query(ch, query);
 
-        if (highlight) {
-            g_string_append_printf(markup,
-                "<span weight='bold' foreground='#FFD700'>%s</span>",
-                escaped);
-        } else {
-            g_string_append(markup, escaped);
-        }
+        if (highlight && !in_span)
+            pos = emit(out, pos, HIGHLIGHT_OPEN, strlen(HIGHLIGHT_OPEN));
+        else if (!highlight && in_span)
+            pos = emit(out, pos, HIGHLIGHT_CLOSE, strlen(HIGHLIGHT_CLOSE));
+        in_span = highlight;
 
-        g_free(escaped);
+        pos = emit_escaped(out, pos, ch);
     }
 
-    g_free(exact_matches);
-    return g_string_free(markup, FALSE);
+    if (in_span)
+        pos = emit(out, pos, HIGHLIGHT_CLOSE, strlen(HIGHLIGHT_CLOSE));
+
+    return pos;
+}
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+char *create_highlighted_markup(PluckArena *arena,
+                                const char *text,
+                                const char *query)
+{
+    int text_len = (int)strlen(text);
+
+    /* Per-character highlight map. */
+    gboolean *exact_matches = arena_alloc(arena, sizeof(gboolean) * (gsize)text_len);
+    memset(exact_matches, 0, sizeof(gboolean) * (gsize)text_len);
+    gboolean  has_exact     = find_exact_matches(text, query,
+                                                 exact_matches, text_len);
+
+    gsize len = write_markup(NULL, text, text_len,
+                             exact_matches, has_exact, query);
+
+    char *markup = arena_alloc(arena, len + 1);
+    write_markup(markup, text, text_len, exact_matches, has_exact, query);
+    markup[len] = '\0';
+
+    return markup;
 }
@@ -3,27 +3,33 @@
  *
  * Provides a single public function that, given a file-path string and the
  * user's current query, returns a Pango markup string with matching
- * characters highlighted in bold gold.
+ * characters highlighted in bold gold.  All memory comes from the caller's
+ * per-query arena.
  */
 
 #ifndef PLUCK_SEARCH_H
 #define PLUCK_SEARCH_H
 
+#include "arena.h"
+
 #include <glib.h>
 
 /**
  * create_highlighted_markup:
+ * @arena: Arena the match map and the returned string are allocated from.
  * @text:  The plain-text string to annotate (e.g. a file path).
  * @query: The search string typed by the user.
  *
- * Returns a newly-allocated Pango markup string.  Where @query appears as
- * a contiguous substring of @text (case-insensitive) the matching characters
- * are wrapped in a bold, gold-coloured &lt;span&gt;.  When no exact run is
- * found the function falls back to highlighting every character of @text
- * that also appears anywhere in @query.
+ * Returns a Pango markup string allocated from @arena.  Where @query appears
+ * as a contiguous substring of @text (case-insensitive) the matching
+ * characters are wrapped in a bold, gold-coloured &lt;span&gt;.  When no
+ * exact run is found the function falls back to highlighting every character
+ * of @text that also appears anywhere in @query.
  *
- * The caller is responsible for freeing the returned string with g_free().
+ * The string lives until @arena is reset; it must not be passed to g_free().
  */
-char *create_highlighted_markup(const char *text, const char *query);
+char *create_highlighted_markup(PluckArena *arena,
+                                const char *text,
+                                const char *query);
 
 #endif /* PLUCK_SEARCH_H */
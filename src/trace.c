@@ -0,0 +1,40 @@
+/**
+ * trace.c — Optional startup phase tracing implementation.
+ *
+ * Timestamps come from g_get_monotonic_time() so they are unaffected by
+ * wall-clock adjustments.  Output goes straight to stderr, unbuffered, so a
+ * trace is still complete if the process is killed mid-startup.
+ */
+
+#include "trace.h"
+
+#include <glib.h>
+#include <stdio.h>
+
+/* Monotonic time (µs) captured by trace_init(). */
+static gint64 trace_start;
+
+/* TRUE when PLUCK_TRACE was set at start-up. */
+static gboolean trace_enabled;
+
+/* -------------------------------------------------------------------------
+ * Public API
+ * ---------------------------------------------------------------------- */
+
+void trace_init(void)
+{
+    trace_start = g_get_monotonic_time();
+
+    const char *env = g_getenv("PLUCK_TRACE");
+    trace_enabled = env && *env;
+}
+
+void trace_mark(const char *phase)
+{
+    if (!trace_enabled)
+        return;
+
+    gint64 elapsed = g_get_monotonic_time() - trace_start;
+    fprintf(stderr, "pluck-trace: %8.3f ms  %s\n",
+            (double)elapsed / 1000.0, phase);
+}
@@ -0,0 +1,32 @@
+/**
+ * trace.h — Optional startup phase tracing.
+ *
+ * When the PLUCK_TRACE environment variable is set to a non-empty value,
+ * each call to trace_mark() prints the time elapsed since trace_init() to
+ * stderr.  This is used to measure hotkey-to-visible latency, phase by
+ * phase, from main() to the first presented frame.  When tracing is
+ * disabled trace_mark() is a cheap no-op.
+ */
+
+#ifndef PLUCK_TRACE_H
+#define PLUCK_TRACE_H
+
+/**
+ * trace_init:
+ *
+ * Records the reference timestamp and reads PLUCK_TRACE.  Call this as the
+ * very first statement in main() so every later mark is measured from
+ * process start-up.
+ */
+void trace_init(void);
+
+/**
+ * trace_mark:
+ * @phase: Short, human-readable name of the phase that just completed.
+ *
+ * Prints "pluck-trace: <elapsed ms>  <phase>" to stderr when tracing is
+ * enabled; does nothing otherwise.
+ */
+void trace_mark(const char *phase);
+
+#endif /* PLUCK_TRACE_H */
@@ -6,12 +6,28 @@
  *   • Handle keyboard input (Escape to dismiss, arrow keys via GTK defaults).
  *   • Run fd + fzf on every keystroke and populate the results list.
  *   • Apply minimal CSS (rounded window corners, search entry margins).
+ *
+ * Start-up is split in two so the search entry reaches the screen as soon as
+ * possible.  activate() builds only the window, layer-shell surface, entry
+ * and an empty scroll container (so the first frame already has its final
+ * geometry), then presents.  Once the first frame has been painted,
+ * finish_setup() runs from an idle callback and builds the results list.
+ * Text typed in the meantime simply accumulates in the entry and is searched
+ * as soon as the list exists, so no keystrokes are lost.
+ *
+ * Each search runs out of a per-query arena: the shell command, fzf's
+ * output, match maps, markup and result records are all allocated from it
+ * and dropped together when the next keystroke resets it.  The result rows
+ * themselves are created once and reused, so a steady-state query performs
+ * no heap allocations of its own.
  */
 
 #include "ui.h"
+#include "arena.h"
 #include "config.h"
 #include "files.h"
 #include "search.h"
+#include "trace.h"
 
 #include <gtk/gtk.h>
 #include <gtk4-layer-shell.h>
@@ -21,11 +37,11 @@
 /* Maximum number of search results shown at one time. */
 #define MAX_RESULTS 10
 
-/* Maximum length of the fd + fzf shell command string. */
-#define CMD_BUFFER_SIZE 4096
+/* Chunk size of the per-query arena; one chunk covers a typical query. */
+#define QUERY_ARENA_CHUNK_SIZE (64 * 1024)
 
-/* Maximum length of a single result line from fzf. */
-#define RESULT_LINE_SIZE 1024
+/* Initial buffer size when reading fzf's output; doubled as needed. */
+#define OUTPUT_READ_SIZE 4096
 
 /* Fraction of monitor width used for the overlay window. */
 #define WINDOW_WIDTH_FRACTION  0.5
@@ -50,19 +66,97 @@ static const char *PLUCK_CSS =
  * ---------------------------------------------------------------------- */
 
 /**
- * clear_list:
- * @list: The GtkListBox whose rows should be removed.
+ * shell_quote:
+ * @arena: Arena the quoted string is allocated from.
+ * @str:   The string to quote.
  *
- * Removes every child row from @list, leaving it empty.
+ * Returns @str wrapped in single quotes, with each embedded single quote
+ * written as '\'' — the same quoting g_shell_quote() produces, so paths with
+ * spaces, quotes, or other special characters cannot inject arbitrary shell
+ * commands.
  */
-static void clear_list(GtkListBox *list)
+static char *shell_quote(PluckArena *arena, const char *str)
 {
-    GtkWidget *child = gtk_widget_get_first_child(GTK_WIDGET(list));
-    while (child) {
-        GtkWidget *next = gtk_widget_get_next_sibling(child);
-        gtk_list_box_remove(list, child);
-        child = next;
+    gsize len = 2;
+    for (const char *p = str; *p; p++)
+        len += (*p == '\'') ? 4 : 1;
+
+    char *out = arena_alloc(arena, len + 1);
+    char *o   = out;
+
+    *o++ = '\'';
+    for (const char *p = str; *p; p++) {
+        if (*p == '\'') {
+            memcpy(o, "'\\''", 4);
+            o += 4;
+        } else {
+            *o++ = *p;
+        }
+    }
+    *o++ = '\'';
+    *o   = '\0';
+
+    return out;
+}
+
+/**
+ * read_output:
+ * @fp:    Stream to drain.
+ * @arena: Arena the buffer is allocated from.
+ *
+ * Reads @fp to EOF into a single NUL-terminated arena buffer, growing it as
+ * needed so arbitrarily long lines are kept intact.
+ */
+static char *read_output(FILE *fp, PluckArena *arena)
+{
+    gsize cap = OUTPUT_READ_SIZE;
+    gsize len = 0;
+    char *buf = arena_alloc(arena, cap);
+
+    for (;;) {
+        /* Always keep one byte free for the terminator. */
+        if (cap - len < 2) {
+            char *bigger = arena_alloc(arena, cap * 2);
+            memcpy(bigger, buf, len);
+            buf  = bigger;
+            cap *= 2;
+        }
+
+        gsize n = fread(buf + len, 1, cap - len - 1, fp);
+        if (n == 0)
+            break;
+        len += n;
     }
+
+    buf[len] = '\0';
+    return buf;
+}
+
+/**
+ * result_row_new:
+ *
+ * Creates one pooled result row: a GtkListBoxRow wrapping a middle-
+ * ellipsised GtkLabel.  The row starts hidden until a search fills it.
+ */
+static GtkWidget *result_row_new(void)
+{
+    GtkWidget *row   = gtk_list_box_row_new();
+    GtkWidget *label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+
+    /* Ellipsise in the middle so long paths remain readable. */
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_MIDDLE);
+    gtk_label_set_max_width_chars(GTK_LABEL(label), 1);
+    gtk_widget_set_hexpand(label, TRUE);
+
+    gtk_widget_set_margin_start(label, 12);
+    gtk_widget_set_margin_end(label, 12);
+    gtk_widget_set_margin_top(label, 4);
+    gtk_widget_set_margin_bottom(label, 4);
+
+    gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), label);
+    gtk_widget_set_visible(row, FALSE);
+    return row;
 }
 
 /**
@@ -86,17 +180,50 @@ static void apply_css(void)
  * Internal types
  * ---------------------------------------------------------------------- */
 
+/**
+ * PluckResult:
+ *
+ * One search hit.  Both strings live in the query arena.
+ */
+typedef struct {
+    const char *path;
+    const char *markup;
+} PluckResult;
+
 /**
  * PluckUI:
  *
- * Bundles the window and search entry pointers so that signal handlers
- * which need both can receive them through a single user_data pointer.
+ * Bundles the widget pointers and per-window search state so that signal
+ * handlers which need several of them can receive them through a single
+ * user_data pointer.  @list, @rows and @arena are NULL until finish_setup()
+ * has run.  @results holds the @n_results hits currently shown, row for
+ * row; it lives in @arena and is replaced by every search.
  */
 typedef struct {
-    GtkWindow      *win;
-    GtkSearchEntry *entry;
+    GtkWindow         *win;
+    GtkScrolledWindow *scroll;
+    GtkSearchEntry    *entry;
+    GtkListBox        *list;
+    GtkWidget         *rows[MAX_RESULTS];
+    PluckArena        *arena;
+    PluckResult       *results;
+    int                n_results;
 } PluckUI;
 
+/**
+ * pluck_ui_free:
+ * @data: The PluckUI to release.
+ *
+ * GDestroyNotify for the window's "pluck-ui" data; frees the query arena
+ * along with the bundle.  The rows are owned by the list box.
+ */
+static void pluck_ui_free(gpointer data)
+{
+    PluckUI *ui = data;
+    arena_free(ui->arena);
+    g_free(ui);
+}
+
 /* -------------------------------------------------------------------------
  * Signal handlers
  * ---------------------------------------------------------------------- */
@@ -105,88 +232,104 @@ typedef struct {
  * on_row_activated:
  *
  * Called when the user clicks a result row or presses Enter on it.
- * Extracts the plain-text file path stored in the row's GtkLabel and
- * delegates to open_file(), which tries the default application first and
- * falls back to revealing the file in the file manager.
+ * Looks up the file path of the matching result record and delegates to
+ * open_file(), which tries the default application first and falls back to
+ * revealing the file in the file manager.
  */
 static void on_row_activated(GtkListBox    *list,
                               GtkListBoxRow *row,
                               gpointer       user_data)
 {
     (void)list;
-    GtkWindow *win   = GTK_WINDOW(user_data);
-    GtkWidget *label = gtk_list_box_row_get_child(row);
+    PluckUI *ui    = user_data;
+    int      index = gtk_list_box_row_get_index(row);
 
-    if (label && GTK_IS_LABEL(label)) {
-        const char *filepath = gtk_label_get_text(GTK_LABEL(label));
-        if (filepath && *filepath)
-            open_file(filepath, win);
-    }
+    if (index >= 0 && index < ui->n_results)
+        open_file(ui->results[index].path, ui->win);
 }
 
 /**
  * update_results:
+ * @ui: The UI bundle; @ui->list must already exist.
  *
- * Connected to the GtkSearchEntry "search-changed" signal.
- * Clears the current results list, then pipes the current query through
- * `fd | fzf` and appends up to MAX_RESULTS highlighted rows.
+ * Resets the query arena, pipes the entry's current query through
+ * `fd | fzf`, and fills up to MAX_RESULTS pooled rows with highlighted
+ * results, hiding the rest.
  */
-static void update_results(GtkSearchEntry *entry, gpointer user_data)
+static void update_results(PluckUI *ui)
 {
-    GtkListBox *list  = GTK_LIST_BOX(user_data);
-    clear_list(list);
-
-    const char *query = gtk_editable_get_text(GTK_EDITABLE(entry));
-    if (!query || !*query)
-        return;
-
-    /* Shell-quote both arguments so that paths with spaces, quotes, or other
-     * special characters cannot inject arbitrary shell commands. */
-    gchar *quoted_root  = g_shell_quote(search_root);
-    gchar *quoted_query = g_shell_quote(query);
-
-    char cmd[CMD_BUFFER_SIZE];
-    snprintf(cmd, sizeof(cmd),
-             "fd --type f --hidden . %s | fzf -f %s | head -n %d",
-             quoted_root, quoted_query, MAX_RESULTS);
-
-    g_free(quoted_root);
-    g_free(quoted_query);
-
-    FILE *fp = popen(cmd, "r");
-    if (!fp)
-        return;
-
-    char line[RESULT_LINE_SIZE];
-    while (fgets(line, sizeof(line), fp)) {
-        /* Strip trailing newline. */
-        line[strcspn(line, "\n")] = '\0';
-
-        char      *markup = create_highlighted_markup(line, query);
-        GtkWidget *row    = gtk_list_box_row_new();
+    PluckArena *arena = ui->arena;
+    arena_reset(arena);
+
+    /* Resetting the arena invalidated the previous records. */
+    PluckResult *results = arena_alloc(arena, sizeof(PluckResult) * MAX_RESULTS);
+    ui->results   = results;
+    ui->n_results = 0;
+    int          count   = 0;
+
+    const char *query = gtk_editable_get_text(GTK_EDITABLE(ui->entry));
+    if (query && *query) {
+        char *quoted_root  = shell_quote(arena, search_root);
+        char *quoted_query = shell_quote(arena, query);
+
+        static const char fmt[] = "fd --type f --hidden . %s | fzf -f %s | head -n %d";
+        int   cmd_len = snprintf(NULL, 0, fmt, quoted_root, quoted_query, MAX_RESULTS);
+        char *cmd     = arena_alloc(arena, (gsize)cmd_len + 1);
+        snprintf(cmd, (gsize)cmd_len + 1, fmt, quoted_root, quoted_query, MAX_RESULTS);
+
+        FILE *fp = popen(cmd, "r");
+        if (fp) {
+            char *line = read_output(fp, arena);
+            pclose(fp);
+
+            /* Split the output in place into one result per line. */
+            while (*line && count < MAX_RESULTS) {
+                char *eol = strchr(line, '\n');
+                if (eol)
+                    *eol = '\0';
+
+                if (*line) {
+                    results[count].path   = line;
+                    results[count].markup = create_highlighted_markup(arena, line, query);
+                    count++;
+                }
+
+                if (!eol)
+                    break;
+                line = eol + 1;
+            }
+        }
+    }
 
-        /* The label stores the plain path as text and displays markup. */
-        GtkWidget *label = gtk_label_new(line);
-        gtk_label_set_markup(GTK_LABEL(label), markup);
-        gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+    gtk_list_box_unselect_all(ui->list);
 
-        /* Ellipsise in the middle so long paths remain readable. */
-        gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_MIDDLE);
-        gtk_label_set_max_width_chars(GTK_LABEL(label), 1);
-        gtk_widget_set_hexpand(label, TRUE);
+    for (int i = 0; i < MAX_RESULTS; i++) {
+        GtkWidget *row = ui->rows[i];
 
-        gtk_widget_set_margin_start(label, 12);
-        gtk_widget_set_margin_end(label, 12);
-        gtk_widget_set_margin_top(label, 4);
-        gtk_widget_set_margin_bottom(label, 4);
+        if (i < count) {
+            GtkWidget *label = gtk_list_box_row_get_child(GTK_LIST_BOX_ROW(row));
+            gtk_label_set_markup(GTK_LABEL(label), results[i].markup);
+        }
+        gtk_widget_set_visible(row, i < count);
+    }
 
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), label);
-        gtk_list_box_append(list, row);
+    ui->n_results = count;
+}
 
-        g_free(markup);
-    }
+/**
+ * on_search_changed:
+ *
+ * Connected to the GtkSearchEntry "search-changed" signal.  Runs the search
+ * once the results list exists; before that the query is left buffered in
+ * the entry and finish_setup() picks it up.
+ */
+static void on_search_changed(GtkSearchEntry *entry, gpointer user_data)
+{
+    (void)entry;
+    PluckUI *ui = user_data;
 
-    pclose(fp);
+    if (ui->list)
+        update_results(ui);
 }
 
 /**
@@ -239,6 +382,89 @@ static gboolean on_key_pressed(GtkEventControllerKey *controller,
     return FALSE;
 }
 
+/* -------------------------------------------------------------------------
+ * Deferred start-up
+ * ---------------------------------------------------------------------- */
+
+/**
+ * finish_setup:
+ * @user_data: The window, with a reference held for this callback.
+ *
+ * Idle callback scheduled after the first frame.  Fills the scroll container
+ * built by activate() with the results list and its pooled rows, creates the
+ * query arena, connects the list's signals and, if the user has already
+ * typed something, runs the first search.
+ */
+static gboolean finish_setup(gpointer user_data)
+{
+    GtkWindow *win = GTK_WINDOW(user_data);
+
+    /* The window may have been dismissed before the first idle. */
+    if (!gtk_widget_get_mapped(GTK_WIDGET(win)))
+        return G_SOURCE_REMOVE;
+
+    PluckUI *ui = g_object_get_data(G_OBJECT(win), "pluck-ui");
+
+    GtkListBox *list = GTK_LIST_BOX(gtk_list_box_new());
+    gtk_list_box_set_selection_mode(list, GTK_SELECTION_SINGLE);
+    gtk_widget_set_vexpand(GTK_WIDGET(list), FALSE);
+    gtk_scrolled_window_set_child(ui->scroll, GTK_WIDGET(list));
+
+    /* Rows are created once and reused by every search. */
+    for (int i = 0; i < MAX_RESULTS; i++) {
+        ui->rows[i] = result_row_new();
+        gtk_list_box_append(list, ui->rows[i]);
+    }
+
+    g_signal_connect(list, "row-activated", G_CALLBACK(on_row_activated), ui);
+    ui->arena = arena_new(QUERY_ARENA_CHUNK_SIZE);
+    ui->list  = list;
+    trace_mark("results list built");
+
+    /* Flush anything typed while the list did not exist yet. */
+    const char *query = gtk_editable_get_text(GTK_EDITABLE(ui->entry));
+    if (query && *query) {
+        update_results(ui);
+        trace_mark("buffered query searched");
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * on_after_paint:
+ *
+ * One-shot handler for the frame clock's "after-paint" signal.  Marks the
+ * first presented frame and schedules finish_setup() for the next idle.
+ */
+static void on_after_paint(GdkFrameClock *clock, gpointer user_data)
+{
+    GtkWindow *win = GTK_WINDOW(user_data);
+
+    g_signal_handlers_disconnect_by_func(clock, on_after_paint, win);
+    trace_mark("first frame painted");
+
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, finish_setup,
+                    g_object_ref(win), g_object_unref);
+}
+
+/**
+ * on_map:
+ *
+ * Called once the window is mapped and has a frame clock; hooks the clock
+ * so the rest of the start-up work waits for the first painted frame.
+ */
+static void on_map(GtkWidget *widget, gpointer user_data)
+{
+    (void)user_data;
+
+    g_signal_handlers_disconnect_by_func(widget, on_map, NULL);
+    trace_mark("window mapped");
+
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(widget);
+    g_signal_connect(clock, "after-paint", G_CALLBACK(on_after_paint), widget);
+}
+
 /* -------------------------------------------------------------------------
  * Public API
  * ---------------------------------------------------------------------- */
@@ -246,6 +472,7 @@ static gboolean on_key_pressed(GtkEventControllerKey *controller,
 void activate(GtkApplication *app, gpointer user_data)
 {
     (void)user_data;
+    trace_mark("activate");
 
     GtkWindow *win = GTK_WINDOW(gtk_application_window_new(app));
 
@@ -263,6 +490,7 @@ void activate(GtkApplication *app, gpointer user_data)
         margin_top = (int)(geo.height * WINDOW_TOP_FRACTION);
         g_object_unref(monitor);
     }
+    trace_mark("monitor queried");
 
     /* ---- Attach to the Wayland layer shell ---- */
     gtk_layer_init_for_window(win);
@@ -280,8 +508,9 @@ void activate(GtkApplication *app, gpointer user_data)
 
     gtk_window_set_default_size(win, win_width, -1);
     gtk_window_set_resizable(win, FALSE);
+    trace_mark("layer shell configured");
 
-    /* ---- Widget tree ---- */
+    /* ---- Widget tree (the results list itself is deferred) ---- */
     GtkBox *box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 0));
     gtk_widget_set_vexpand(GTK_WIDGET(box), FALSE);
     gtk_widget_set_size_request(GTK_WIDGET(box), win_width, -1);
@@ -291,8 +520,11 @@ void activate(GtkApplication *app, gpointer user_data)
     GtkSearchEntry *entry = GTK_SEARCH_ENTRY(gtk_search_entry_new());
     gtk_widget_set_hexpand(GTK_WIDGET(entry), TRUE);
     gtk_box_append(box, GTK_WIDGET(entry));
+    gtk_window_set_focus(win, GTK_WIDGET(entry));
 
-    /* Scrollable results list */
+    /* Scroll container for the results list.  It is built empty here so its
+     * margins are part of the first frame and the window never grows once
+     * finish_setup() adds the list. */
     GtkScrolledWindow *scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new());
     gtk_scrolled_window_set_policy(scroll, GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
     gtk_scrolled_window_set_max_content_height(scroll, RESULTS_MAX_HEIGHT);
@@ -301,30 +533,32 @@ void activate(GtkApplication *app, gpointer user_data)
     gtk_widget_set_margin_start(GTK_WIDGET(scroll), 12);
     gtk_widget_set_margin_end(GTK_WIDGET(scroll), 12);
     gtk_widget_set_margin_bottom(GTK_WIDGET(scroll), 8);
-
-    GtkListBox *list = GTK_LIST_BOX(gtk_list_box_new());
-    gtk_list_box_set_selection_mode(list, GTK_SELECTION_SINGLE);
-    gtk_widget_set_vexpand(GTK_WIDGET(list), FALSE);
-    gtk_scrolled_window_set_child(scroll, GTK_WIDGET(list));
     gtk_box_append(box, GTK_WIDGET(scroll));
 
     /* ---- Signal connections ---- */
-    g_signal_connect(list,  "row-activated", G_CALLBACK(on_row_activated), win);
-    g_signal_connect(entry, "search-changed", G_CALLBACK(update_results), list);
-
-    GtkEventController *key_ctrl = gtk_event_controller_key_new();
-    gtk_event_controller_set_propagation_phase(key_ctrl, GTK_PHASE_CAPTURE);
-
-    PluckUI *ui = g_new(PluckUI, 1);
-    ui->win   = win;
-    ui->entry = entry;
+    PluckUI *ui = g_new0(PluckUI, 1);
+    ui->win    = win;
+    ui->scroll = scroll;
+    ui->entry  = entry;
     /* ui is freed automatically when the window (and therefore the
      * controller) is destroyed. */
-    g_object_set_data_full(G_OBJECT(win), "pluck-ui", ui, g_free);
+    g_object_set_data_full(G_OBJECT(win), "pluck-ui", ui, pluck_ui_free);
+
+    g_signal_connect(entry, "search-changed", G_CALLBACK(on_search_changed), ui);
 
+    GtkEventController *key_ctrl = gtk_event_controller_key_new();
+    gtk_event_controller_set_propagation_phase(key_ctrl, GTK_PHASE_CAPTURE);
     g_signal_connect(key_ctrl, "key-pressed", G_CALLBACK(on_key_pressed), ui);
     gtk_widget_add_controller(GTK_WIDGET(win), key_ctrl);
 
+    g_signal_connect(win, "map", G_CALLBACK(on_map), NULL);
+    trace_mark("entry built");
+
+    /* The CSS only sets window corners and entry margins, both of which
+     * shape the first frame, so it is applied before presenting. */
     apply_css();
+    trace_mark("css applied");
+
     gtk_window_present(win);
+    trace_mark("window presented");
 }